@@ -1,4 +1,5 @@
 #include <chrono>
+#include <fstream>
 #include <iomanip>
 #include <iostream>
 #include <plotter/application.hpp>
@@ -7,26 +8,42 @@
 
 namespace plotter {
 
-application::application() {
+application::application() : application(plotter::session::live()) {}
+
+application::application(const plotter::session& s) : session{s} {
   if (!font.loadFromFile("font.otf"))
     throw std::runtime_error("Font could not be loaded!");
 
+  if (session.mode == session.REPLAY) {
+    record.load(session.file_path);
+    return;
+  }
   execute_task = std::async(std::launch::async, [this]() { execute(); });
 }
 
-application::~application() { execute_task.wait(); }
+application::~application() {
+  // Destructors must not throw. Errors of the execution, like a recording
+  // that could not be saved, are reported instead.
+  try {
+    if (execute_task.valid())
+      execute_task.get();
+    else
+      execute();
+  } catch (const std::exception& e) {
+    std::cerr << e.what() << '\n';
+  }
+}
 
 application& application::fit_view() {
   x_min = y_min = INFINITY;
   x_max = y_max = -INFINITY;
 
   for (const auto& path : sampled_paths) {
-    for (size_t i = 0; i < path.x_data.size(); ++i) {
-      x_min = std::min(x_min, path.x_data[i]);
-      x_max = std::max(x_max, path.x_data[i]);
-      y_min = std::min(y_min, path.y_data[i]);
-      y_max = std::max(y_max, path.y_data[i]);
-    }
+    const auto bounds = path.data.bounds();
+    x_min = std::min(x_min, bounds.min[0]);
+    x_max = std::max(x_max, bounds.max[0]);
+    y_min = std::min(y_min, bounds.min[1]);
+    y_max = std::max(y_max, bounds.max[1]);
   }
 
   view_x_min = x_min - 0.2 * (x_max - x_min);
@@ -97,54 +114,151 @@ application& application::execute() {
   constexpr float fps = 60;
   constexpr float frame_duration = 1 / fps;
 
-  sf::ContextSettings settings;
-  settings.antialiasingLevel = 8;
-  window.create(sf::VideoMode(500, 500), "Plotter", sf::Style::Default,
-                settings);
-  window.setVerticalSyncEnabled(false);
+  // Every application is only executed once, also when 'execute' is
+  // additionally called explicitly.
+  if (executed.exchange(true)) return *this;
+
+  const auto replay = session.mode == session.REPLAY;
+  const auto width = replay ? record.width : 500u;
+  const auto height = replay ? record.height : 500u;
+
+  if (!headless()) {
+    sf::ContextSettings settings;
+    settings.antialiasingLevel = 8;
+    window.create(sf::VideoMode(width, height), "Plotter", sf::Style::Default,
+                  settings);
+    window.setVerticalSyncEnabled(false);
+  }
+  record.width = width;
+  record.height = height;
+  resize(width, height);
 
   // Do automatic adjustsments before starting to plot.
   fit_view();
 
   auto old_time = high_resolution_clock::now();
-  while (window.isOpen()) {
-    const auto new_time = high_resolution_clock::now();
-    const auto process_duration = duration<float>(new_time - old_time).count();
-    if (process_duration < frame_duration)
-      this_thread::sleep_for(
-          duration<float>(frame_duration - process_duration));
-    old_time = new_time;
+  auto old_frame_time = old_time;
+  // Paced replays start each frame at the sum of all recorded frame times.
+  auto deadline = old_time;
+  while (open) {
+    if (!replay) {
+      const auto new_time = high_resolution_clock::now();
+      const auto process_duration =
+          duration<float>(new_time - old_time).count();
+      if (process_duration < frame_duration)
+        this_thread::sleep_for(
+            duration<float>(frame_duration - process_duration));
+      old_time = new_time;
+    } else if (session.paced && replay_index < record.frames.size()) {
+      // Otherwise, replays run as fast as possible.
+      deadline += microseconds(record.frames[replay_index].time);
+      this_thread::sleep_until(deadline);
+    }
+
+    const auto frame_time = high_resolution_clock::now();
+    poll_input();
+    input.time =
+        duration_cast<microseconds>(frame_time - old_frame_time).count();
+    old_frame_time = frame_time;
+    if (session.mode == session.RECORD) record.frames.push_back(input);
 
     process_mouse();
     process_events();
     if (update) {
       update = false;
       fit_tiks();
-      window.clear(background_color);
+      target().clear(background_color);
       render();
-      window.display();
+      if (headless())
+        headless_texture.display();
+      else
+        window.display();
+      if (replay)
+        frame_times.push_back(
+            duration<float>(high_resolution_clock::now() - frame_time).count());
     }
   }
+
+  if (session.mode == session.RECORD) record.save(session.file_path);
+  if (replay) report_replay(frame_duration);
   return *this;
 }
 
+void application::report_replay(float frame_duration) {
+  report_frame_times(std::cout, frame_times, frame_duration);
+
+  if (!session.timings_file_path.empty()) {
+    std::ofstream file{session.timings_file_path};
+    if (!file)
+      throw std::runtime_error("Timings file '" + session.timings_file_path +
+                               "' could not be opened for writing!");
+    file << std::fixed << std::setprecision(3);
+    for (auto t : frame_times) file << 1000.0f * t << '\n';
+  }
+
+  size_t samples = 0;
+  size_t bytes = 0;
+  for (const auto& path : sampled_paths) {
+    samples += path.data.size();
+    bytes += path.data.bytes();
+  }
+  float render_time = 0;
+  for (auto t : frame_times) render_time += t;
+
+  std::cout << "bytes/sample = "
+            << static_cast<float>(bytes) / std::max<size_t>(samples, 1) << '\n'
+            << "samples/s    = "
+            << ((render_time > 0) ? (rendered_samples / render_time) : 0.0f)
+            << '\n';
+}
+
+void application::poll_input() {
+  if (session.mode != session.REPLAY) {
+    const auto mouse_pos = sf::Mouse::getPosition(window);
+    input.mouse_x = mouse_pos.x;
+    input.mouse_y = mouse_pos.y;
+    input.mouse_left = sf::Mouse::isButtonPressed(sf::Mouse::Left);
+    input.focus = window.hasFocus();
+    input.events.clear();
+    sf::Event event{};
+    while (window.pollEvent(event)) input.events.push_back(event);
+    return;
+  }
+
+  // Real events are still polled to keep the window responsive. To get
+  // deterministic replays, they are ignored unless they stop the replay.
+  bool stop = false;
+  sf::Event event{};
+  if (!headless())
+    while (window.pollEvent(event))
+      stop = stop || event.type == sf::Event::Closed ||
+             (event.type == sf::Event::KeyPressed &&
+              event.key.code == sf::Keyboard::Escape);
+
+  if (stop || replay_index >= record.frames.size()) {
+    input = {};
+    close();
+    return;
+  }
+  input = record.frames[replay_index++];
+}
+
 void application::process_mouse() {
   old_mouse_x = mouse_x;
   old_mouse_y = mouse_y;
-  const auto mouse_pos = sf::Mouse::getPosition(window);
-  mouse_x = mouse_pos.x;
-  mouse_y = mouse_pos.y;
+  mouse_x = input.mouse_x;
+  mouse_y = input.mouse_y;
   mouse_diff_x = mouse_x - old_mouse_x;
   mouse_diff_y = mouse_y - old_mouse_y;
 
-  if (window.hasFocus()) {
+  if (input.focus) {
     if (mouse_x >= plot_x_min && mouse_x < plot_x_max &&
         mouse_y >= plot_y_min && mouse_y < plot_y_max) {
       mouse_focus = PLOT_FOCUS;
     } else if (mouse_x >= plot_x_min && mouse_x < plot_x_max && mouse_y >= 0 &&
-               mouse_y < window.getSize().y) {
+               mouse_y < target().getSize().y) {
       mouse_focus = X_AXIS_FOCUS;
-    } else if (mouse_x >= 0 && mouse_x < window.getSize().x &&
+    } else if (mouse_x >= 0 && mouse_x < target().getSize().x &&
                mouse_y >= plot_y_min && mouse_y < plot_y_max) {
       mouse_focus = Y_AXIS_FOCUS;
     } else {
@@ -156,15 +270,17 @@ void application::process_mouse() {
 }
 
 void application::process_events() {
-  sf::Event event{};
-  while (window.pollEvent(event)) {
+  for (const auto& event : input.events) {
     switch (event.type) {
       case sf::Event::Closed:
-        window.close();
+        close();
         break;
 
       case sf::Event::Resized:
-        resize();
+        // Replayed windows have to follow the recorded size.
+        if (session.mode == session.REPLAY && !headless())
+          window.setSize({event.size.width, event.size.height});
+        resize(event.size.width, event.size.height);
         break;
 
       case sf::Event::MouseButtonPressed:
@@ -201,7 +317,7 @@ void application::process_events() {
       case sf::Event::KeyPressed:
         switch (event.key.code) {
           case sf::Keyboard::Escape:
-            window.close();
+            close();
             break;
           case sf::Keyboard::A:
             fit_aspect_view();
@@ -211,7 +327,7 @@ void application::process_events() {
     }
   }
 
-  if (sf::Mouse::isButtonPressed(sf::Mouse::Left) && window.hasFocus()) {
+  if (input.mouse_left && input.focus) {
     if (mouse_click_focus == PLOT_FOCUS || mouse_click_focus == X_AXIS_FOCUS) {
       const auto move_x =
           (view_x_max - view_x_min) * mouse_diff_x / (plot_x_max - plot_x_min);
@@ -233,7 +349,7 @@ void application::draw_plot_background() {
   rect.setSize({plot_x_max - plot_x_min, plot_y_max - plot_y_min});
   rect.setPosition({plot_x_min, plot_y_min});
   rect.setFillColor(plot_background_color);
-  window.draw(rect);
+  target().draw(rect);
 }
 
 void application::draw_tiks() {
@@ -261,7 +377,7 @@ void application::draw_tiks() {
       gridline.setFillColor(m_gridlines_color);
       gridline.setSize({m_gridlines_size, plot_y_max - plot_y_min});
       gridline.setPosition({pixel_i - 0.5f * m_gridlines_size, plot_y_min});
-      window.draw(gridline);
+      target().draw(gridline);
 
     } else {
       std::stringstream output{};
@@ -275,25 +391,25 @@ void application::draw_tiks() {
       text.setStyle(sf::Text::Bold);
       text.setPosition(pixel_i - 0.5f * text.getLocalBounds().width,
                        plot_y_max + 2 * length);
-      window.draw(text);
+      target().draw(text);
       // text.setPosition(pixel_i - 0.5f * text.getLocalBounds().width,
       //                  plot_y_min - 2 * length -
       //                  text.getLocalBounds().height);
-      // window.draw(text);
+      // target().draw(text);
 
       sf::RectangleShape gridline;
       gridline.setFillColor(gridlines_color);
       gridline.setSize({gridlines_size, plot_y_max - plot_y_min});
       gridline.setPosition({pixel_i - 0.5f * gridlines_size, plot_y_min});
-      window.draw(gridline);
+      target().draw(gridline);
     }
 
     tics_shape.setPosition({pixel_i - 0.5f * thickness, plot_y_min});
     tics_shape.setSize({thickness, -length});
-    window.draw(tics_shape);
+    target().draw(tics_shape);
     tics_shape.setPosition({pixel_i - 0.5f * thickness, plot_y_max});
     tics_shape.setSize({thickness, length});
-    window.draw(tics_shape);
+    target().draw(tics_shape);
   }
 
   int min_y_tic = std::ceil(view_y_min * (y_m_tics + 1) / y_tics);
@@ -320,7 +436,7 @@ void application::draw_tiks() {
       gridline.setFillColor(m_gridlines_color);
       gridline.setSize({plot_x_max - plot_x_min, m_gridlines_size});
       gridline.setPosition({plot_x_min, pixel_j - 0.5f * m_gridlines_size});
-      window.draw(gridline);
+      target().draw(gridline);
 
     } else {
       std::stringstream output{};
@@ -334,46 +450,49 @@ void application::draw_tiks() {
       text.setStyle(sf::Text::Bold);
       text.setPosition(plot_x_min - 2 * length - text.getLocalBounds().width,
                        pixel_j - text.getLocalBounds().height);
-      window.draw(text);
+      target().draw(text);
       // text.setPosition(pixel_i - 0.5f * text.getLocalBounds().width,
       //                  plot_y_min - 2 * length -
       //                  text.getLocalBounds().height);
-      // window.draw(text);
+      // target().draw(text);
 
       sf::RectangleShape gridline;
       gridline.setFillColor(gridlines_color);
       gridline.setSize({plot_x_max - plot_x_min, gridlines_size});
       gridline.setPosition({plot_x_min, pixel_j - 0.5f * gridlines_size});
-      window.draw(gridline);
+      target().draw(gridline);
     }
 
     tics_shape.setPosition({plot_x_min, pixel_j - 0.5f * thickness});
     tics_shape.setSize({-length, thickness});
-    window.draw(tics_shape);
+    target().draw(tics_shape);
     tics_shape.setPosition({plot_x_max, pixel_j - 0.5f * thickness});
     tics_shape.setSize({length, thickness});
-    window.draw(tics_shape);
+    target().draw(tics_shape);
   }
 }
 
 void application::draw_function() {
   texture.clear(sf::Color{0, 0, 0, 0});
 
+  const auto columns =
+      static_cast<size_t>(std::max(1.0f, plot_x_max - plot_x_min));
+  std::vector<sf::Vector2f> pixels{};
   for (const auto& path : sampled_paths) {
-    for (size_t i = 0; i < path.x_data.size() - 1; ++i) {
-      const auto pixel_i = (path.x_data[i] - view_x_min) /
-                           (view_x_max - view_x_min) *
-                           (plot_x_max - plot_x_min);
-      const auto pixel_j = (view_y_max - path.y_data[i]) /
-                           (view_y_max - view_y_min) *
-                           (plot_y_max - plot_y_min);
-
-      const auto pixel_i1 = (path.x_data[i + 1] - view_x_min) /
-                            (view_x_max - view_x_min) *
-                            (plot_x_max - plot_x_min);
-      const auto pixel_j1 = (view_y_max - path.y_data[i + 1]) /
-                            (view_y_max - view_y_min) *
-                            (plot_y_max - plot_y_min);
+    pixels.clear();
+    rendered_samples += path.data.for_each_decimated(
+        view_x_min, view_x_max, columns, [&](float x, float y) {
+          pixels.push_back({(x - view_x_min) / (view_x_max - view_x_min) *
+                                (plot_x_max - plot_x_min),
+                            (view_y_max - y) / (view_y_max - view_y_min) *
+                                (plot_y_max - plot_y_min)});
+        });
+
+    for (size_t i = 0; i + 1 < pixels.size(); ++i) {
+      const auto pixel_i = pixels[i].x;
+      const auto pixel_j = pixels[i].y;
+      const auto pixel_i1 = pixels[i + 1].x;
+      const auto pixel_j1 = pixels[i + 1].y;
 
       sf::RectangleShape line;
       line.setSize({std::sqrt((pixel_i1 - pixel_i) * (pixel_i1 - pixel_i) +
@@ -381,7 +500,7 @@ void application::draw_function() {
                     path.line_size});
       line.setOrigin(0, 0.5f * path.line_size);
       line.rotate(180.0f / M_PI *
-                  std::atan((pixel_j1 - pixel_j) / (pixel_i1 - pixel_i)));
+                  std::atan2(pixel_j1 - pixel_j, pixel_i1 - pixel_i));
       line.setFillColor(path.line_color);
       line.setPosition({pixel_i, pixel_j});
       texture.draw(line);
@@ -393,20 +512,11 @@ void application::draw_function() {
       texture.draw(dot);
     }
 
-    for (size_t i = 0; i < path.x_data.size(); ++i) {
+    for (const auto& pixel : pixels) {
       sf::CircleShape point_shape(path.point_size);
       point_shape.setFillColor(path.point_color);
       point_shape.setOrigin(path.point_size, path.point_size);
-
-      const auto pixel_i = (path.x_data[i] - view_x_min) /
-                           (view_x_max - view_x_min) *
-                           (plot_x_max - plot_x_min);
-
-      const auto pixel_j = (view_y_max - path.y_data[i]) /
-                           (view_y_max - view_y_min) *
-                           (plot_y_max - plot_y_min);
-
-      point_shape.setPosition({pixel_i, pixel_j});
+      point_shape.setPosition(pixel);
       texture.draw(point_shape);
     }
   }
@@ -414,7 +524,7 @@ void application::draw_function() {
   texture.display();
   sf::Sprite sprite(texture.getTexture());
   sprite.setPosition(plot_x_min, plot_y_min);
-  window.draw(sprite);
+  target().draw(sprite);
 }
 
 void application::draw_plot_border() {
@@ -424,7 +534,7 @@ void application::draw_plot_border() {
   rect.setFillColor(sf::Color{0, 0, 0, 0});
   rect.setOutlineThickness(plot_border_size);
   rect.setOutlineColor(plot_border_color);
-  window.draw(rect);
+  target().draw(rect);
 }
 
 void application::render() {
@@ -434,22 +544,38 @@ void application::render() {
   draw_plot_border();
 }
 
-void application::resize() {
-  window.setView(
-      sf::View{sf::FloatRect{0, 0, static_cast<float>(window.getSize().x),
-                             static_cast<float>(window.getSize().y)}});
+void application::resize(unsigned width, unsigned height) {
+  sf::ContextSettings settings;
+  settings.antialiasingLevel = 8;
+
+  if (headless() && !headless_texture.create(width, height, settings))
+    throw std::runtime_error("Off-screen texture could not be created!");
+  target().setView(sf::View{sf::FloatRect{0, 0, static_cast<float>(width),
+                                          static_cast<float>(height)}});
 
   plot_x_min = plot_pad;
   plot_y_min = plot_pad;
-  plot_x_max = window.getSize().x - plot_pad;
-  plot_y_max = window.getSize().y - plot_pad;
+  plot_x_max = width - plot_pad;
+  plot_y_max = height - plot_pad;
 
-  sf::ContextSettings settings;
-  settings.antialiasingLevel = 8;
   texture.create(plot_x_max - plot_x_min, plot_y_max - plot_y_min, settings);
   texture.setSmooth(true);
 
   update = true;
 }
 
+void application::close() {
+  open = false;
+  if (!headless()) window.close();
+}
+
+bool application::headless() const {
+  return session.mode == session.REPLAY && session.headless;
+}
+
+sf::RenderTarget& application::target() {
+  if (headless()) return headless_texture;
+  return window;
+}
+
 }  // namespace plotter
\ No newline at end of file
@@ -5,6 +5,8 @@
 #include <cmath>
 #include <future>
 #include <list>
+#include <plotter/interaction.hpp>
+#include <plotter/series.hpp>
 #include <thread>
 #include <vector>
 
@@ -13,22 +15,33 @@ namespace plotter {
 class application {
  public:
   application();
+  // In replay mode, the application is not started in the background. Call
+  // 'execute' after adding all plots to run the replay synchronously and get
+  // its errors. Otherwise, it is executed on destruction.
+  explicit application(const plotter::session& s);
   ~application();
 
   application& fit_view();
   application& fit_aspect_view();
   application& fit_tiks();
   template <typename InputIt1, typename InputIt2>
-  application& plot(InputIt1 x_first, InputIt1 x_last, InputIt2 y_first);
+  application& plot(InputIt1 x_first, InputIt1 x_last, InputIt2 y_first,
+                    series::encoding e = series::FLOAT);
   template <typename Function>
-  application& plot(Function&& f, float min, float max, size_t samples);
+  application& plot(Function&& f, float min, float max, size_t samples,
+                    series::encoding e = series::FLOAT);
   application& execute();
 
  private:
+  void poll_input();
   void process_mouse();
   void process_events();
   void render();
-  void resize();
+  void resize(unsigned width, unsigned height);
+  void close();
+  bool headless() const;
+  sf::RenderTarget& target();
+  void report_replay(float frame_duration);
 
   void draw_plot_background();
   void draw_tiks();
@@ -38,10 +51,20 @@ class application {
  private:
   std::future<void> execute_task;
   sf::RenderWindow window;
+  sf::RenderTexture headless_texture;
   sf::RenderTexture texture;
 
+  std::atomic<bool> executed = false;
+  bool open = true;
   bool update = true;
 
+  plotter::session session{};
+  plotter::interaction record{};
+  size_t replay_index = 0;
+  interaction::frame input{};
+  std::vector<float> frame_times{};
+  size_t rendered_samples = 0;
+
   sf::Color background_color{sf::Color::White};
 
   int old_mouse_x = 0;
@@ -55,8 +78,8 @@ class application {
     PLOT_FOCUS,
     X_AXIS_FOCUS,
     Y_AXIS_FOCUS
-  } mouse_focus,
-      mouse_click_focus;
+  } mouse_focus = NONE,
+    mouse_click_focus = NONE;
 
   float view_x_min;
   float view_x_max;
@@ -91,20 +114,19 @@ class application {
   struct sampled_path {
     sampled_path() = default;
     template <typename InputIt1, typename InputIt2>
-    sampled_path(InputIt1 x_first, InputIt1 x_last, InputIt2 y_first);
+    sampled_path(InputIt1 x_first, InputIt1 x_last, InputIt2 y_first,
+                 series::encoding e)
+        : data{x_first, x_last, y_first, e} {}
     template <typename Function>
-    sampled_path(Function&& f, float min, float max, size_t samples);
+    sampled_path(Function&& f, float min, float max, size_t samples,
+                 series::encoding e)
+        : data{std::forward<Function>(f), min, max, samples, e} {}
 
     sf::Color point_color{sf::Color::Black};
     float point_size = 0.0f;
     sf::Color line_color{sf::Color::Black};
     float line_size = 1.5f;
-    std::vector<float> x_data{};
-    std::vector<float> y_data{};
-    float x_min;
-    float x_max;
-    float y_min;
-    float y_max;
+    series data{};
   };
   std::list<sampled_path> sampled_paths{};
 
@@ -123,8 +145,8 @@ class application {
 
 template <typename InputIt1, typename InputIt2>
 application& application::plot(InputIt1 x_first, InputIt1 x_last,
-                               InputIt2 y_first) {
-  sampled_paths.emplace_back(x_first, x_last, y_first);
+                               InputIt2 y_first, series::encoding e) {
+  sampled_paths.emplace_back(x_first, x_last, y_first, e);
   // x_data.clear();
   // y_data.clear();
   // auto x_it = x_first;
@@ -136,23 +158,10 @@ application& application::plot(InputIt1 x_first, InputIt1 x_last,
   return *this;
 }
 
-template <typename InputIt1, typename InputIt2>
-application::sampled_path::sampled_path(InputIt1 x_first, InputIt1 x_last,
-                                        InputIt2 y_first) {
-  x_data.clear();
-  y_data.clear();
-  auto x_it = x_first;
-  auto y_it = y_first;
-  for (; x_it != x_last; ++x_it, ++y_it) {
-    x_data.push_back(*x_it);
-    y_data.push_back(*y_it);
-  }
-}
-
 template <typename Function>
 application& application::plot(Function&& f, float min, float max,
-                               size_t samples) {
-  sampled_paths.emplace_back(std::forward<Function>(f), min, max, samples);
+                               size_t samples, series::encoding e) {
+  sampled_paths.emplace_back(std::forward<Function>(f), min, max, samples, e);
 
   // x_min = min;
   // x_max = max;
@@ -168,20 +177,4 @@ application& application::plot(Function&& f, float min, float max,
   return *this;
 }
 
-template <typename Function>
-application::sampled_path::sampled_path(Function&& f, float min, float max,
-                                        size_t samples) {
-  x_min = min;
-  x_max = max;
-  x_data.resize(samples);
-  y_data.resize(samples);
-  for (size_t i = 0; i < samples; ++i) {
-    const auto scale = static_cast<float>(i) / (samples - 1);
-    const auto x = x_min * (1.0f - scale) + x_max * scale;
-    const auto y = f(x);
-    x_data[i] = x;
-    y_data[i] = y;
-  }
-}
-
 }  // namespace plotter
\ No newline at end of file
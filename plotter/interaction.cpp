@@ -0,0 +1,252 @@
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <plotter/interaction.hpp>
+#include <stdexcept>
+#include <type_traits>
+
+namespace plotter {
+
+namespace {
+
+// File layout (little endian):
+//   header: "PLTR" | u8 version | u16 width | u16 height | u32 frame count
+//   frame:  u32 time | i16 mouse x | i16 mouse y | u8 flags | u16 events
+//   event:  u8 type | type-dependent payload
+constexpr char magic[4] = {'P', 'L', 'T', 'R'};
+constexpr uint8_t version = 1;
+
+enum : uint8_t { MOUSE_LEFT_FLAG = 1 << 0, FOCUS_FLAG = 1 << 1 };
+
+template <typename T>
+void write(std::ostream& os, T value) {
+  auto bits = static_cast<std::make_unsigned_t<T>>(value);
+  for (size_t i = 0; i < sizeof(T); ++i, bits >>= 8)
+    os.put(static_cast<char>(bits & 0xff));
+}
+
+template <typename T>
+T read(std::istream& is) {
+  std::make_unsigned_t<T> bits = 0;
+  for (size_t i = 0; i < sizeof(T); ++i) {
+    const auto byte = is.get();
+    if (byte == std::char_traits<char>::eof())
+      throw std::runtime_error("Interaction file is truncated!");
+    bits |= static_cast<std::make_unsigned_t<T>>(byte) << (8 * i);
+  }
+  return static_cast<T>(bits);
+}
+
+bool is_recorded(const sf::Event& event) {
+  switch (event.type) {
+    case sf::Event::Closed:
+    case sf::Event::Resized:
+    case sf::Event::MouseButtonPressed:
+    case sf::Event::MouseButtonReleased:
+    case sf::Event::MouseWheelMoved:
+    case sf::Event::KeyPressed:
+      return true;
+    default:
+      return false;
+  }
+}
+
+void write(std::ostream& os, const sf::Event& event) {
+  write<uint8_t>(os, event.type);
+  switch (event.type) {
+    case sf::Event::Resized:
+      write<uint16_t>(os, event.size.width);
+      write<uint16_t>(os, event.size.height);
+      break;
+    case sf::Event::MouseButtonPressed:
+    case sf::Event::MouseButtonReleased:
+      write<uint8_t>(os, event.mouseButton.button);
+      break;
+    case sf::Event::MouseWheelMoved:
+      write<int16_t>(os, event.mouseWheel.delta);
+      break;
+    case sf::Event::KeyPressed:
+      write<int16_t>(os, event.key.code);
+      break;
+    default:
+      break;
+  }
+}
+
+sf::Event read_event(std::istream& is) {
+  sf::Event event{};
+  event.type = static_cast<sf::Event::EventType>(read<uint8_t>(is));
+  switch (event.type) {
+    case sf::Event::Closed:
+      break;
+    case sf::Event::Resized:
+      event.size.width = read<uint16_t>(is);
+      event.size.height = read<uint16_t>(is);
+      break;
+    case sf::Event::MouseButtonPressed:
+    case sf::Event::MouseButtonReleased:
+      event.mouseButton.button =
+          static_cast<sf::Mouse::Button>(read<uint8_t>(is));
+      break;
+    case sf::Event::MouseWheelMoved:
+      event.mouseWheel.delta = read<int16_t>(is);
+      break;
+    case sf::Event::KeyPressed:
+      event.key.code = static_cast<sf::Keyboard::Key>(read<int16_t>(is));
+      break;
+    default:
+      throw std::runtime_error("Interaction file contains unknown event!");
+  }
+  return event;
+}
+
+}  // namespace
+
+void interaction::save(const std::string& file_path) const {
+  std::ofstream file{file_path, std::ios::binary};
+  if (!file)
+    throw std::runtime_error("Interaction file '" + file_path +
+                             "' could not be opened for writing!");
+
+  file.write(magic, sizeof(magic));
+  write<uint8_t>(file, version);
+  write<uint16_t>(file, width);
+  write<uint16_t>(file, height);
+  write<uint32_t>(file, frames.size());
+
+  for (const auto& frame : frames) {
+    write<uint32_t>(file, frame.time);
+    write<int16_t>(file, frame.mouse_x);
+    write<int16_t>(file, frame.mouse_y);
+    write<uint8_t>(file, (frame.mouse_left ? MOUSE_LEFT_FLAG : 0) |
+                             (frame.focus ? FOCUS_FLAG : 0));
+    const auto event_count =
+        std::count_if(begin(frame.events), end(frame.events), is_recorded);
+    write<uint16_t>(file, event_count);
+    for (const auto& event : frame.events)
+      if (is_recorded(event)) write(file, event);
+  }
+}
+
+void interaction::load(const std::string& file_path) {
+  std::ifstream file{file_path, std::ios::binary};
+  if (!file)
+    throw std::runtime_error("Interaction file '" + file_path +
+                             "' could not be opened for reading!");
+
+  char file_magic[sizeof(magic)]{};
+  file.read(file_magic, sizeof(file_magic));
+  if (!std::equal(std::begin(magic), std::end(magic), file_magic) ||
+      read<uint8_t>(file) != version)
+    throw std::runtime_error("'" + file_path +
+                             "' is not a valid interaction file!");
+
+  width = read<uint16_t>(file);
+  height = read<uint16_t>(file);
+  // Frames are read one by one such that a corrupt frame count fails on the
+  // first missing frame instead of allocating memory for all of them.
+  const auto frame_count = read<uint32_t>(file);
+  frames.clear();
+  for (uint32_t i = 0; i < frame_count; ++i) {
+    auto& frame = frames.emplace_back();
+    frame.time = read<uint32_t>(file);
+    frame.mouse_x = read<int16_t>(file);
+    frame.mouse_y = read<int16_t>(file);
+    const auto flags = read<uint8_t>(file);
+    frame.mouse_left = flags & MOUSE_LEFT_FLAG;
+    frame.focus = flags & FOCUS_FLAG;
+    const auto event_count = read<uint16_t>(file);
+    for (uint16_t j = 0; j < event_count; ++j)
+      frame.events.push_back(read_event(file));
+  }
+}
+
+interaction pan_zoom_session(size_t event_count) {
+  constexpr uint32_t frame_time = 16667;
+  constexpr int drag_frames = 30;
+  constexpr int wheel_events = 10;
+  constexpr size_t resize_period = 50;
+
+  interaction result{};
+  size_t events = 0;
+  const auto add_frame = [&](int x, int y, bool left,
+                             std::vector<sf::Event> frame_events = {}) {
+    events += frame_events.size();
+    result.frames.push_back({frame_time, x, y, left, true, frame_events});
+  };
+  const auto button_event = [](sf::Event::EventType type) {
+    sf::Event event{};
+    event.type = type;
+    event.mouseButton.button = sf::Mouse::Left;
+    return event;
+  };
+
+  // All positions stay inside the plot of the smallest window size.
+  const int center_x = 250;
+  const int center_y = 250;
+  for (size_t cycle = 0; events < event_count; ++cycle) {
+    if (cycle % resize_period == resize_period - 1) {
+      sf::Event event{};
+      event.type = sf::Event::Resized;
+      event.size.width = (cycle / resize_period % 2) ? 500 : 800;
+      event.size.height = (cycle / resize_period % 2) ? 500 : 600;
+      add_frame(center_x, center_y, false, {event});
+      continue;
+    }
+
+    // drag along a circle
+    add_frame(center_x, center_y, true,
+              {button_event(sf::Event::MouseButtonPressed)});
+    if (events == event_count) break;
+    for (int i = 1; i < drag_frames; ++i) {
+      const auto angle = 6.2831853f * i / drag_frames;
+      add_frame(center_x + std::lround(100 * std::sin(angle)),
+                center_y + std::lround(50 * (1 - std::cos(angle))), true);
+    }
+    add_frame(center_x, center_y, false,
+              {button_event(sf::Event::MouseButtonReleased)});
+
+    // zoom in and out again
+    for (int i = 0; i < wheel_events && events < event_count; ++i) {
+      sf::Event event{};
+      event.type = sf::Event::MouseWheelMoved;
+      event.mouseWheel.delta = (i < wheel_events / 2) ? 1 : -1;
+      add_frame(center_x, center_y, false, {event});
+    }
+  }
+  return result;
+}
+
+void report_frame_times(std::ostream& os, std::vector<float> frame_times,
+                        float frame_duration) {
+  if (frame_times.empty()) {
+    os << "No frames have been rendered.\n";
+    return;
+  }
+
+  std::sort(begin(frame_times), end(frame_times));
+  const auto percentile = [&frame_times](float p) {
+    const auto index = static_cast<size_t>(p * (frame_times.size() - 1));
+    return 1000.0f * frame_times[index];
+  };
+  float mean = 0;
+  for (auto t : frame_times) mean += t;
+  mean *= 1000.0f / frame_times.size();
+  const auto dropped =
+      frame_times.end() - std::upper_bound(begin(frame_times),
+                                           end(frame_times), frame_duration);
+
+  os << std::fixed << std::setprecision(3)  //
+     << "frames  = " << frame_times.size() << '\n'
+     << "mean    = " << mean << " ms\n"
+     << "p50     = " << percentile(0.50f) << " ms\n"
+     << "p90     = " << percentile(0.90f) << " ms\n"
+     << "p99     = " << percentile(0.99f) << " ms\n"
+     << "max     = " << 1000.0f * frame_times.back() << " ms\n"
+     << "dropped = " << dropped << " (> " << 1000.0f * frame_duration
+     << " ms)\n";
+}
+
+}  // namespace plotter
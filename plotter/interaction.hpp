@@ -0,0 +1,60 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace plotter {
+
+// Timestamped stream of everything the application reads from its input
+// devices. It is filled frame by frame in 'application::poll_input' and can
+// be stored in and loaded from a compact binary file to replay a session.
+struct interaction {
+  struct frame {
+    // microseconds since the previous frame
+    uint32_t time = 0;
+    int mouse_x = 0;
+    int mouse_y = 0;
+    bool mouse_left = false;
+    bool focus = false;
+    std::vector<sf::Event> events{};
+  };
+
+  void save(const std::string& file_path) const;
+  void load(const std::string& file_path);
+
+  // initial window size
+  unsigned width = 500;
+  unsigned height = 500;
+  std::vector<frame> frames{};
+};
+
+// Generates a deterministic session of mouse drags, wheel zooms and window
+// resizes containing exactly 'event_count' events. Replaying it is meant to
+// be the same workload on every machine and release.
+interaction pan_zoom_session(size_t event_count);
+
+// Describes where the application gets its input from.
+struct session {
+  enum { LIVE, RECORD, REPLAY } mode = LIVE;
+  std::string file_path{};
+  // Only for replays: render into an off-screen texture instead of a window.
+  bool headless = false;
+  // Only for replays: reproduce the recorded frame timing instead of
+  // feeding frames as fast as possible.
+  bool paced = false;
+  // Only for replays: if not empty, the render time of each frame is written
+  // to this file in milliseconds, one per line.
+  std::string timings_file_path{};
+
+  static session live() { return {}; }
+};
+
+// Prints count, mean, percentiles and dropped frames of the given frame
+// times in seconds. A frame is dropped if it took longer than
+// 'frame_duration'.
+void report_frame_times(std::ostream& os, std::vector<float> frame_times,
+                        float frame_duration);
+
+}  // namespace plotter
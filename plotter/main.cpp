@@ -1,8 +1,93 @@
+#include <fstream>
+#include <iostream>
 #include <plotter/application.hpp>
+#include <string>
 #include <vector>
 using namespace std;
 
-int main() {
+int main(int argc, char** argv) {
+  // plotter [--record <file> | --replay <file> [--headless] [--paced] |
+  //          --generate <file>] [--encoding float|int16|delta]
+  //         [--data <file> | --samples <count>] [--timings <file>]
+  // A data file contains whitespace-separated pairs of x and y values. It is
+  // plotted instead of the example functions. Alternatively, a uniformly
+  // sampled signal with the given number of samples is plotted to benchmark
+  // decimation of series with a lot more samples than pixel columns.
+  plotter::session session{};
+  string data_path{};
+  size_t synthetic_samples = 0;
+  auto encoding = plotter::series::FLOAT;
+  for (int i = 1; i < argc; ++i) {
+    const string arg = argv[i];
+    if (arg == "--encoding" && i + 1 < argc) {
+      const string name = argv[++i];
+      if (name == "float")
+        encoding = plotter::series::FLOAT;
+      else if (name == "int16")
+        encoding = plotter::series::INT16;
+      else if (name == "delta")
+        encoding = plotter::series::DELTA;
+      else {
+        cerr << "Unknown encoding '" << name << "'.\n";
+        return 1;
+      }
+    } else if (arg == "--samples" && i + 1 < argc) {
+      const string count = argv[++i];
+      if (count.find_first_not_of("0123456789") != string::npos ||
+          count.empty()) {
+        cerr << "Invalid sample count '" << count << "'.\n";
+        return 1;
+      }
+      synthetic_samples = stoul(count);
+    } else if (arg == "--data" && i + 1 < argc) {
+      data_path = argv[++i];
+    } else if (arg == "--generate" && i + 1 < argc) {
+      plotter::pan_zoom_session(10000).save(argv[++i]);
+      return 0;
+    } else if (arg == "--record" && i + 1 < argc) {
+      session.mode = session.RECORD;
+      session.file_path = argv[++i];
+    } else if (arg == "--replay" && i + 1 < argc) {
+      session.mode = session.REPLAY;
+      session.file_path = argv[++i];
+    } else if (arg == "--timings" && i + 1 < argc) {
+      session.timings_file_path = argv[++i];
+    } else if (arg == "--headless")
+      session.headless = true;
+    else if (arg == "--paced")
+      session.paced = true;
+  }
+  if ((session.headless || session.paced ||
+       !session.timings_file_path.empty()) &&
+      session.mode != session.REPLAY) {
+    cerr << "'--headless', '--paced' and '--timings' can only be used with "
+            "'--replay'.\n";
+    return 1;
+  }
+
+  if (!data_path.empty() && synthetic_samples > 0) {
+    cerr << "'--data' and '--samples' cannot be used together.\n";
+    return 1;
+  }
+
+  vector<float> x_file_data{}, y_file_data{};
+  if (!data_path.empty()) {
+    ifstream file{data_path};
+    if (!file) {
+      cerr << "Data file '" << data_path << "' could not be opened.\n";
+      return 1;
+    }
+    float x, y;
+    while (file >> x >> y) {
+      x_file_data.push_back(x);
+      y_file_data.push_back(y);
+    }
+    if (!file.eof()) {
+      cerr << "Data file '" << data_path << "' could not be parsed.\n";
+      return 1;
+    }
+  }
+
   const auto x_min = -5.0f;
   const auto x_max = 10.0f;
   const size_t samples = 100;
@@ -15,11 +100,30 @@ int main() {
     y_data[i] = y;
   }
 
-  plotter::application app{};
-  app  //
-      .plot([](float x) { return sin(x); }, -7, 7, 100)
-      .plot([](float x) { return sin(x) / x; }, -15, 15, 100)
-      .plot([](float x) { return 0; }, -15, 15, 100)
-      .plot(begin(x_data), end(x_data), begin(y_data))
-      .fit_view();
+  try {
+    plotter::application app{session};
+    if (synthetic_samples > 0) {
+      app  //
+          .plot([](float x) { return sin(x) + 0.25f * sin(97 * x); }, 0, 100,
+                synthetic_samples, encoding)
+          .fit_view();
+    } else if (!data_path.empty()) {
+      app  //
+          .plot(begin(x_file_data), end(x_file_data), begin(y_file_data),
+                encoding)
+          .fit_view();
+    } else {
+      app  //
+          .plot([](float x) { return sin(x); }, -7, 7, 100, encoding)
+          .plot([](float x) { return sin(x) / x; }, -15, 15, 100, encoding)
+          .plot([](float x) { return 0; }, -15, 15, 100, encoding)
+          .plot(begin(x_data), end(x_data), begin(y_data), encoding)
+          .fit_view();
+    }
+    // Replays are used to gate releases and must report failures.
+    if (session.mode == session.REPLAY) app.execute();
+  } catch (const exception& e) {
+    cerr << e.what() << '\n';
+    return 1;
+  }
 }
\ No newline at end of file
@@ -0,0 +1,185 @@
+#include <plotter/series.hpp>
+
+namespace plotter {
+
+namespace {
+
+// The highest codes are reserved to store non-finite values exactly.
+constexpr uint16_t negative_infinity_code = 0xfffd;
+constexpr uint16_t positive_infinity_code = 0xfffe;
+constexpr uint16_t nan_code = 0xffff;
+constexpr float quantisation_levels = negative_infinity_code - 1;
+
+uint16_t quantise(float y, float min, float max) {
+  if (std::isnan(y)) return nan_code;
+  if (std::isinf(y)) return (y > 0) ? positive_infinity_code
+                                    : negative_infinity_code;
+  const auto scale = (max > min) ? (quantisation_levels / (max - min)) : 0.0f;
+  const auto t = (y - min) * scale;
+  return (t > 0) ? std::lround(std::min(t, quantisation_levels)) : 0;
+}
+
+float dequantise(uint32_t q, float min, float max) {
+  switch (q) {
+    case negative_infinity_code:
+      return -INFINITY;
+    case positive_infinity_code:
+      return INFINITY;
+    case nan_code:
+      return NAN;
+    default:
+      return min + q * ((max - min) / quantisation_levels);
+  }
+}
+
+void write_varint(std::vector<uint8_t>& bytes, uint32_t value) {
+  for (; value >= 0x80; value >>= 7)
+    bytes.push_back(static_cast<uint8_t>(value | 0x80));
+  bytes.push_back(static_cast<uint8_t>(value));
+}
+
+uint32_t read_varint(const uint8_t*& it) {
+  uint32_t value = 0;
+  for (int shift = 0;; shift += 7) {
+    const auto byte = *it++;
+    value |= static_cast<uint32_t>(byte & 0x7f) << shift;
+    if (!(byte & 0x80)) return value;
+  }
+}
+
+}  // namespace
+
+void series::assign_x(std::vector<float>&& x) {
+  count = x.size();
+  x_data.clear();
+  x_origin = (count > 0) ? x.front() : 0.0;
+  x_step = (count > 1) ? (static_cast<double>(x.back()) - x.front()) /
+                             (count - 1)
+                       : 0.0;
+
+  bool is_uniform = true;
+  const auto tolerance = uniform_tolerance * std::abs(x_step);
+  for (size_t i = 0; i < count && is_uniform; ++i)
+    is_uniform = std::abs(x[i] - (x_origin + i * x_step)) <= tolerance;
+
+  if (is_uniform) {
+    x_monotonic = true;
+    return;
+  }
+  x_monotonic = std::is_sorted(begin(x), end(x));
+  x_data = std::move(x);
+}
+
+void series::assign_y(const std::vector<float>& y, encoding e) {
+  y_encoding = e;
+  blocks.clear();
+  y_data.clear();
+  y_bytes.clear();
+
+  for (size_t b = 0; block_begin(b) < count; ++b) {
+    block current{INFINITY, -INFINITY, static_cast<uint32_t>(y_bytes.size())};
+    for (auto i = block_begin(b); i < block_end(b); ++i) {
+      if (!std::isfinite(y[i])) continue;
+      if (y[i] < current.y_min) current.y_min = y[i];
+      if (y[i] > current.y_max) current.y_max = y[i];
+    }
+    blocks.push_back(current);
+    if (y_encoding == FLOAT) continue;
+
+    uint32_t previous = 0;
+    for (auto i = block_begin(b); i < block_end(b); ++i) {
+      const uint32_t q = quantise(y[i], current.y_min, current.y_max);
+      if (y_encoding == INT16) {
+        y_bytes.push_back(static_cast<uint8_t>(q));
+        y_bytes.push_back(static_cast<uint8_t>(q >> 8));
+      } else {
+        // zigzag encoding keeps small negative differences small
+        const auto delta = static_cast<int32_t>(q - previous);
+        write_varint(y_bytes, (static_cast<uint32_t>(delta) << 1) ^
+                                  static_cast<uint32_t>(delta >> 31));
+        previous = q;
+      }
+    }
+  }
+
+  if (y_encoding == FLOAT) y_data = y;
+  y_bytes.shrink_to_fit();
+}
+
+void series::decode(size_t b, float* out) const {
+  const auto n = block_end(b) - block_begin(b);
+  const auto& current = blocks[b];
+
+  if (y_encoding == FLOAT) {
+    std::copy_n(&y_data[block_begin(b)], n, out);
+    return;
+  }
+
+  const uint8_t* it = &y_bytes[current.offset];
+  uint32_t q = 0;
+  for (size_t i = 0; i < n; ++i) {
+    if (y_encoding == INT16) {
+      q = it[0] | (it[1] << 8);
+      it += 2;
+    } else {
+      const auto zigzag = read_varint(it);
+      q += (zigzag >> 1) ^ -(zigzag & 1);
+    }
+    out[i] = dequantise(q, current.y_min, current.y_max);
+  }
+}
+
+std::pair<size_t, size_t> series::visible_range(float view_min,
+                                                float view_max) const {
+  if (!x_monotonic) return {0, count};
+
+  if (uniform()) {
+    if (x_step == 0) return {0, count};
+    // Descending grids are mirrored by swapping the view bounds.
+    const auto first =
+        std::floor(((x_step > 0 ? view_min : view_max) - x_origin) / x_step);
+    const auto last =
+        std::ceil(((x_step > 0 ? view_max : view_min) - x_origin) / x_step) +
+        1;
+    const auto clamp = [this](double i) {
+      return static_cast<size_t>(
+          std::clamp(i, 0.0, static_cast<double>(count)));
+    };
+    return {clamp(first), clamp(std::max(first, last))};
+  }
+
+  auto first = std::lower_bound(begin(x_data), end(x_data), view_min);
+  auto last = std::upper_bound(first, end(x_data), view_max);
+  if (first != begin(x_data)) --first;
+  if (last != end(x_data)) ++last;
+  return {first - begin(x_data), last - begin(x_data)};
+}
+
+aabb<float> series::bounds() const {
+  aabb<float> result{};
+  result.min[0] = result.min[1] = INFINITY;
+  result.max[0] = result.max[1] = -INFINITY;
+  if (count == 0) return result;
+
+  if (uniform()) {
+    result.min[0] = std::min(x(0), x(count - 1));
+    result.max[0] = std::max(x(0), x(count - 1));
+  } else {
+    const auto x_bounds = std::minmax_element(begin(x_data), end(x_data));
+    result.min[0] = *x_bounds.first;
+    result.max[0] = *x_bounds.second;
+  }
+
+  for (const auto& b : blocks) {
+    result.min[1] = std::min(result.min[1], b.y_min);
+    result.max[1] = std::max(result.max[1], b.y_max);
+  }
+  return result;
+}
+
+size_t series::bytes() const {
+  return x_data.size() * sizeof(float) + blocks.size() * sizeof(block) +
+         y_data.size() * sizeof(float) + y_bytes.size();
+}
+
+}  // namespace plotter
@@ -0,0 +1,187 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iterator>
+#include <plotter/aabb.hpp>
+#include <utility>
+#include <vector>
+
+namespace plotter {
+
+// Sampled y values over x stored in a compact form. Uniformly sampled x
+// values are not stored but given by origin, step and count. The y values are
+// split into blocks with their own minimum and maximum. They can be stored as
+// floats, quantised to 16 bit relative to their block range or additionally
+// delta encoded by variable-length integers. Bounds and decimation work on
+// the blocks directly and only decode them when necessary. Both ignore
+// non-finite values. Decimation needs x values on a uniform grid, ascending or
+// descending, or stored in ascending order. Otherwise, all points are given.
+class series {
+ public:
+  enum encoding { FLOAT, INT16, DELTA };
+
+  static constexpr size_t block_size = 256;
+  // Maximal deviation of given x values from a uniform grid, relative to the
+  // grid step, for which the grid is stored implicitly.
+  static constexpr double uniform_tolerance = 1e-2;
+
+  series() = default;
+  template <typename InputIt1, typename InputIt2>
+  series(InputIt1 x_first, InputIt1 x_last, InputIt2 y_first,
+         encoding e = FLOAT);
+  template <typename Function>
+  series(Function&& f, float min, float max, size_t samples,
+         encoding e = FLOAT);
+
+  size_t size() const { return count; }
+  bool uniform() const { return x_data.empty(); }
+  float x(size_t i) const {
+    return uniform() ? static_cast<float>(x_origin + i * x_step) : x_data[i];
+  }
+  aabb<float> bounds() const;
+  // Number of bytes used by the stored samples.
+  size_t bytes() const;
+
+  // Calls 'f(x, y)' for each point of the visible part in [view_min, view_max]
+  // including the neighbors next to it. If there are a lot more points than
+  // the given number of columns, only the minimum and maximum of each column
+  // are given. Returns the number of samples in the visible part.
+  template <typename Function>
+  size_t for_each_decimated(float view_min, float view_max, size_t columns,
+                          Function&& f) const;
+
+ private:
+  struct block {
+    float y_min;
+    float y_max;
+    uint32_t offset;
+  };
+
+  void assign_x(std::vector<float>&& x);
+  void assign_y(const std::vector<float>& y, encoding e);
+  size_t block_begin(size_t b) const { return b * block_size; }
+  size_t block_end(size_t b) const {
+    return std::min(count, (b + 1) * block_size);
+  }
+  void decode(size_t b, float* out) const;
+  std::pair<size_t, size_t> visible_range(float view_min,
+                                          float view_max) const;
+
+ private:
+  size_t count = 0;
+  double x_origin = 0;
+  double x_step = 0;
+  // Only used for non-uniform x values.
+  std::vector<float> x_data{};
+  // uniform grid or ascending x values
+  bool x_monotonic = true;
+
+  encoding y_encoding = FLOAT;
+  std::vector<block> blocks{};
+  // Only used for FLOAT.
+  std::vector<float> y_data{};
+  // Only used for INT16 and DELTA.
+  std::vector<uint8_t> y_bytes{};
+};
+
+template <typename InputIt1, typename InputIt2>
+series::series(InputIt1 x_first, InputIt1 x_last, InputIt2 y_first,
+               encoding e) {
+  std::vector<float> x{};
+  std::vector<float> y{};
+  auto x_it = x_first;
+  auto y_it = y_first;
+  for (; x_it != x_last; ++x_it, ++y_it) {
+    x.push_back(*x_it);
+    y.push_back(*y_it);
+  }
+  assign_x(std::move(x));
+  assign_y(y, e);
+}
+
+template <typename Function>
+series::series(Function&& f, float min, float max, size_t samples,
+               encoding e) {
+  count = samples;
+  x_origin = min;
+  x_step = (samples > 1) ? (static_cast<double>(max) - min) / (samples - 1)
+                         : 0.0;
+  x_monotonic = true;
+  std::vector<float> y(samples);
+  for (size_t i = 0; i < samples; ++i) y[i] = f(x(i));
+  assign_y(y, e);
+}
+
+template <typename Function>
+size_t series::for_each_decimated(float view_min, float view_max,
+                                  size_t columns, Function&& f) const {
+  if (count == 0) return 0;
+  const auto range = visible_range(view_min, view_max);
+  const auto visible = range.second - range.first;
+  float values[block_size];
+  size_t decoded = blocks.size();
+
+  // Columns can only be computed for views with positive width.
+  if (!x_monotonic || !(view_max > view_min) || visible <= 2 * columns) {
+    for (auto i = range.first; i < range.second; ++i) {
+      const auto b = i / block_size;
+      if (b != decoded) decode(decoded = b, values);
+      f(x(i), values[i - block_begin(b)]);
+    }
+    return visible;
+  }
+
+  const auto column_width = (view_max - view_min) / columns;
+  const auto column = [&](float position) {
+    return static_cast<int64_t>(
+        std::floor((position - view_min) / column_width));
+  };
+  auto current = column(x(range.first));
+  auto y_min = INFINITY;
+  auto y_max = -INFINITY;
+  const auto flush = [&]() {
+    if (y_min > y_max) return;
+    const auto center = view_min + (current + 0.5f) * column_width;
+    f(center, y_min);
+    if (y_max != y_min) f(center, y_max);
+    y_min = INFINITY;
+    y_max = -INFINITY;
+  };
+
+  for (auto i = range.first; i < range.second;) {
+    const auto b = i / block_size;
+    const auto last = block_end(b);
+    // Whole blocks inside a single column are merged without decoding.
+    if (i == block_begin(b) && last <= range.second) {
+      const auto c = column(x(i));
+      if (c == column(x(last - 1))) {
+        if (c != current) {
+          flush();
+          current = c;
+        }
+        y_min = std::min(y_min, blocks[b].y_min);
+        y_max = std::max(y_max, blocks[b].y_max);
+        i = last;
+        continue;
+      }
+    }
+    if (b != decoded) decode(decoded = b, values);
+    for (; i < std::min(last, range.second); ++i) {
+      // Like the block ranges, columns only contain finite values.
+      const auto value = values[i - block_begin(b)];
+      if (!std::isfinite(value)) continue;
+      const auto c = column(x(i));
+      if (c != current) {
+        flush();
+        current = c;
+      }
+      y_min = std::min(y_min, value);
+      y_max = std::max(y_max, value);
+    }
+  }
+  flush();
+  return visible;
+}
+
+}  // namespace plotter
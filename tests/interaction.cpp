@@ -0,0 +1,172 @@
+#include <cassert>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <plotter/interaction.hpp>
+#include <sstream>
+#include <string>
+#include <vector>
+using namespace std;
+using namespace plotter;
+
+bool equal(const sf::Event& a, const sf::Event& b) {
+  if (a.type != b.type) return false;
+  switch (a.type) {
+    case sf::Event::Resized:
+      return a.size.width == b.size.width && a.size.height == b.size.height;
+    case sf::Event::MouseButtonPressed:
+    case sf::Event::MouseButtonReleased:
+      return a.mouseButton.button == b.mouseButton.button;
+    case sf::Event::MouseWheelMoved:
+      return a.mouseWheel.delta == b.mouseWheel.delta;
+    case sf::Event::KeyPressed:
+      return a.key.code == b.key.code;
+    default:
+      return true;
+  }
+}
+
+bool equal(const interaction& a, const interaction& b) {
+  if (a.width != b.width || a.height != b.height ||
+      a.frames.size() != b.frames.size())
+    return false;
+  for (size_t i = 0; i < a.frames.size(); ++i) {
+    const auto& f = a.frames[i];
+    const auto& g = b.frames[i];
+    if (f.time != g.time || f.mouse_x != g.mouse_x ||
+        f.mouse_y != g.mouse_y || f.mouse_left != g.mouse_left ||
+        f.focus != g.focus || f.events.size() != g.events.size())
+      return false;
+    for (size_t j = 0; j < f.events.size(); ++j)
+      if (!equal(f.events[j], g.events[j])) return false;
+  }
+  return true;
+}
+
+interaction round_trip(const interaction& record) {
+  const string file_path = "interaction-test.rec";
+  record.save(file_path);
+  interaction result{};
+  result.load(file_path);
+  remove(file_path.c_str());
+  return result;
+}
+
+int main() {
+  // Every recorded event type survives a round trip.
+  {
+    interaction record{};
+    record.width = 640;
+    record.height = 480;
+
+    sf::Event closed{};
+    closed.type = sf::Event::Closed;
+    sf::Event resized{};
+    resized.type = sf::Event::Resized;
+    resized.size.width = 1920;
+    resized.size.height = 1080;
+    sf::Event pressed{};
+    pressed.type = sf::Event::MouseButtonPressed;
+    pressed.mouseButton.button = sf::Mouse::Left;
+    sf::Event released{};
+    released.type = sf::Event::MouseButtonReleased;
+    released.mouseButton.button = sf::Mouse::Right;
+    sf::Event wheel{};
+    wheel.type = sf::Event::MouseWheelMoved;
+    wheel.mouseWheel.delta = -3;
+    sf::Event key{};
+    key.type = sf::Event::KeyPressed;
+    key.key.code = sf::Keyboard::Escape;
+
+    record.frames.push_back({16667, 10, 20, true, true, {pressed, wheel}});
+    record.frames.push_back({0, -5, 32000, false, false, {}});
+    record.frames.push_back({4000000000u, 250, 250, false, true,
+                             {resized, released, key, closed}});
+    assert(equal(round_trip(record), record));
+  }
+
+  // Events that are not handled by the application are not stored.
+  {
+    interaction record{};
+    sf::Event lost_focus{};
+    lost_focus.type = sf::Event::LostFocus;
+    sf::Event wheel{};
+    wheel.type = sf::Event::MouseWheelMoved;
+    wheel.mouseWheel.delta = 1;
+    record.frames.push_back({1, 0, 0, false, true, {lost_focus, wheel}});
+    const auto result = round_trip(record);
+    assert(result.frames.size() == 1);
+    assert(result.frames[0].events.size() == 1);
+    assert(equal(result.frames[0].events[0], wheel));
+  }
+
+  // The generated benchmark session is deterministic and has the requested
+  // number of events.
+  {
+    const auto record = pan_zoom_session(10000);
+    size_t events = 0;
+    for (const auto& frame : record.frames) events += frame.events.size();
+    assert(events == 10000);
+    assert(equal(record, pan_zoom_session(10000)));
+    assert(equal(round_trip(record), record));
+  }
+
+  // Frame time statistics are computed from the sorted frame times.
+  {
+    vector<float> frame_times{};
+    for (int i = 100; i > 0; --i) frame_times.push_back(i / 1000.0f);
+    ostringstream os{};
+    report_frame_times(os, frame_times, 0.0505f);
+    const auto report = os.str();
+    assert(report.find("frames  = 100\n") != string::npos);
+    assert(report.find("mean    = 50.500 ms\n") != string::npos);
+    assert(report.find("p50     = 50.000 ms\n") != string::npos);
+    assert(report.find("p90     = 90.000 ms\n") != string::npos);
+    assert(report.find("p99     = 99.000 ms\n") != string::npos);
+    assert(report.find("max     = 100.000 ms\n") != string::npos);
+    assert(report.find("dropped = 50 (> 50.500 ms)\n") != string::npos);
+
+    ostringstream empty{};
+    report_frame_times(empty, {}, 0.0505f);
+    assert(empty.str() == "No frames have been rendered.\n");
+  }
+
+  // Truncated files with a huge frame count are rejected without trying to
+  // allocate all frames.
+  {
+    const string file_path = "interaction-test.rec";
+    interaction record{};
+    record.frames.resize(2);
+    record.save(file_path);
+    {
+      fstream file{file_path, ios::binary | ios::in | ios::out};
+      file.seekp(9);
+      const char count[] = {'\xff', '\xff', '\xff', '\xff'};
+      file.write(count, sizeof(count));
+    }
+    bool thrown = false;
+    try {
+      interaction{}.load(file_path);
+    } catch (const std::runtime_error&) {
+      thrown = true;
+    }
+    remove(file_path.c_str());
+    assert(thrown);
+  }
+
+  // Invalid files are rejected.
+  {
+    const string file_path = "interaction-test.rec";
+    FILE* file = fopen(file_path.c_str(), "wb");
+    fputs("PLTR", file);
+    fclose(file);
+    bool thrown = false;
+    try {
+      interaction{}.load(file_path);
+    } catch (const std::runtime_error&) {
+      thrown = true;
+    }
+    remove(file_path.c_str());
+    assert(thrown);
+  }
+}
@@ -0,0 +1,210 @@
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <map>
+#include <plotter/series.hpp>
+#include <utility>
+#include <vector>
+using namespace std;
+using namespace plotter;
+
+constexpr series::encoding encodings[] = {series::FLOAT, series::INT16,
+                                          series::DELTA};
+
+vector<pair<float, float>> points(const series& s, float view_min,
+                                  float view_max, size_t columns) {
+  vector<pair<float, float>> result{};
+  s.for_each_decimated(view_min, view_max, columns,
+                       [&](float x, float y) { result.push_back({x, y}); });
+  return result;
+}
+
+int main() {
+  const size_t n = 10000;
+  vector<float> x(n), y(n);
+  for (size_t i = 0; i < n; ++i) {
+    const auto scale = static_cast<float>(i) / (n - 1);
+    x[i] = -5.0f * (1.0f - scale) + 10.0f * scale;
+    y[i] = sin(3 * x[i]) + 0.1f * x[i];
+  }
+
+  // Uniform x values are detected and all encodings round trip within the
+  // quantisation error of their blocks.
+  for (auto e : encodings) {
+    const series s(begin(x), end(x), begin(y), e);
+    assert(s.uniform());
+    assert(s.size() == n);
+
+    const auto b = s.bounds();
+    assert(b.min[0] == -5.0f && b.max[0] == 10.0f);
+    assert(b.min[1] <= b.max[1]);
+
+    const auto p = points(s, -100, 100, n);
+    assert(p.size() == n);
+    const auto tolerance = (e == series::FLOAT) ? 0.0f : 1e-4f;
+    for (size_t i = 0; i < n; ++i) {
+      assert(abs(p[i].first - x[i]) <= 1e-5f);
+      assert(abs(p[i].second - y[i]) <= tolerance);
+    }
+
+    if (e == series::FLOAT)
+      assert(s.bytes() < n * sizeof(float) + n / 10);
+    else
+      assert(s.bytes() < n * sizeof(uint16_t) + n / 10);
+  }
+
+  // Decimation gives the minimum and maximum of each column, also when whole
+  // blocks are merged without decoding them.
+  for (auto e : encodings) {
+    const series s(begin(x), end(x), begin(y), e);
+    const size_t columns = 7;
+    const float view_min = -2;
+    const float view_max = 8;
+    const auto width = (view_max - view_min) / columns;
+
+    vector<pair<float, float>> p{};
+    const auto visible = s.for_each_decimated(
+        view_min, view_max, columns,
+        [&](float x, float y) { p.push_back({x, y}); });
+    assert(visible < n);
+
+    map<int64_t, pair<float, float>> expected{};
+    for (size_t i = 0; i < n; ++i) {
+      // visible samples and their direct neighbors
+      if ((i + 1 < n && s.x(i + 1) <= view_min) ||
+          (i > 0 && s.x(i - 1) >= view_max))
+        continue;
+      const auto c =
+          static_cast<int64_t>(floor((s.x(i) - view_min) / width));
+      auto it = expected.insert({c, {INFINITY, -INFINITY}}).first;
+      it->second.first = min(it->second.first, y[i]);
+      it->second.second = max(it->second.second, y[i]);
+    }
+
+    assert(p.size() >= 2 * columns);
+    const auto tolerance = (e == series::FLOAT) ? 0.0f : 1e-4f;
+    size_t merged_columns = 0;
+    for (size_t i = 0; i < p.size(); ++merged_columns) {
+      const auto c =
+          static_cast<int64_t>(floor((p[i].first - view_min) / width));
+      const auto it = expected.find(c);
+      assert(it != expected.end());
+      // Columns with equal minimum and maximum only give a single point.
+      const auto j = (i + 1 < p.size() && p[i + 1].first == p[i].first)
+                         ? i + 1
+                         : i;
+      assert(abs(p[i].second - it->second.first) <= tolerance);
+      assert(abs(p[j].second - it->second.second) <= tolerance);
+      i = j + 1;
+    }
+    assert(merged_columns == expected.size());
+  }
+
+  // Non-uniform x values are stored and the visible range includes the
+  // neighbors of the view.
+  {
+    vector<float> u(20), v(20);
+    for (size_t i = 0; i < u.size(); ++i) {
+      u[i] = i * i;
+      v[i] = i;
+    }
+    for (auto e : encodings) {
+      const series s(begin(u), end(u), begin(v), e);
+      assert(!s.uniform());
+      const auto b = s.bounds();
+      assert(b.min[0] == 0 && b.max[0] == 361);
+      assert(b.min[1] == 0 && b.max[1] == 19);
+
+      const auto p = points(s, 10, 50, 100);
+      assert(p.size() == 6);
+      assert(p.front().first == 9 && p.back().first == 64);
+      for (const auto& [px, py] : p) assert(abs(py * py - px) <= 1e-2f);
+    }
+  }
+
+  // Slightly perturbed x values are still stored as uniform grid.
+  {
+    vector<float> u(x);
+    for (size_t i = 0; i < n; i += 2) u[i] += 1e-5f;
+    assert(series(begin(u), end(u), begin(y)).uniform());
+  }
+
+  // Descending uniform grids are clipped to the view and decimated like
+  // ascending ones.
+  for (auto e : encodings) {
+    vector<float> u(x.rbegin(), x.rend()), v(y.rbegin(), y.rend());
+    const series s(begin(u), end(u), begin(v), e);
+    const series t(begin(x), end(x), begin(y), e);
+    assert(s.uniform());
+
+    const auto visible = s.for_each_decimated(2, 3, 10000, [](float, float) {});
+    assert(visible < n / 10);
+    assert(visible == t.for_each_decimated(2, 3, 10000, [](float, float) {}));
+
+    auto p = points(s, -2, 8, 7);
+    auto q = points(t, -2, 8, 7);
+    assert(p.size() == q.size());
+    sort(begin(p), end(p));
+    sort(begin(q), end(q));
+    const auto tolerance = (e == series::FLOAT) ? 0.0f : 1e-4f;
+    for (size_t i = 0; i < p.size(); ++i) {
+      assert(p[i].first == q[i].first);
+      assert(abs(p[i].second - q[i].second) <= tolerance);
+    }
+  }
+
+  // Equal x values and empty views are not decimated.
+  {
+    const vector<float> u(n, 1.0f);
+    const series s(begin(u), end(u), begin(y));
+    assert(s.uniform());
+    assert(s.for_each_decimated(1, 1, 10, [](float, float) {}) == n);
+    const series t(begin(x), end(x), begin(y));
+    assert(t.for_each_decimated(2, 1, 10, [](float, float) {}) == 0);
+  }
+
+  // Decimation ignores non-finite values, whether their block is merged or
+  // decoded.
+  for (auto e : encodings) {
+    vector<float> v(y);
+    for (size_t i = 0; i < n; i += 97) v[i] = (i % 2) ? INFINITY : NAN;
+    const series s(begin(x), end(x), begin(v), e);
+    for (size_t columns : {3, 40}) {
+      size_t count = 0;
+      s.for_each_decimated(-5, 10, columns, [&](float, float y) {
+        assert(isfinite(y));
+        ++count;
+      });
+      assert(count > 0);
+    }
+  }
+
+  // A single sample is handled by both constructors.
+  for (auto e : encodings) {
+    const series f([](float x) { return 2 * x; }, 3, 3, 1, e);
+    const float u[] = {3}, v[] = {6};
+    const series s(begin(u), end(u), begin(v), e);
+    for (const auto& t : {f, s}) {
+      assert(t.size() == 1);
+      const auto b = t.bounds();
+      assert(b.min[0] == 3 && b.max[0] == 3);
+      assert(b.min[1] == 6 && b.max[1] == 6);
+      const auto p = points(t, 0, 10, 100);
+      assert(p.size() == 1 && p[0].first == 3 && p[0].second == 6);
+    }
+  }
+
+  // Non-finite values are kept by all encodings.
+  for (auto e : encodings) {
+    const float u[] = {0, 1, 2, 3, 4, 5};
+    const float v[] = {1, NAN, INFINITY, 2, -INFINITY, 3};
+    const series s(begin(u), end(u), begin(v), e);
+    const auto b = s.bounds();
+    assert(b.min[1] == 1 && b.max[1] == 3);
+    const auto p = points(s, 0, 5, 100);
+    assert(p.size() == 6);
+    assert(p[0].second == 1 && isnan(p[1].second));
+    assert(p[2].second == INFINITY && p[3].second == 2);
+    assert(p[4].second == -INFINITY && p[5].second == 3);
+  }
+}